@@ -0,0 +1,108 @@
+#include "string_convert.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+
+template <typename F>
+static double measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// the byte at a time loop json_escape replaces
+static std::string scalar_json_escape(std::string const& str)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    std::string result;
+    result.reserve(str.size() + str.size() / 8);
+    for (unsigned char c : str) {
+        switch (c) {
+        case '"':  result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\b': result += "\\b"; break;
+        case '\f': result += "\\f"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                result += "\\u00";
+                result += hex_digits[c >> 4];
+                result += hex_digits[c & 0xf];
+            } else {
+                result += static_cast<char>(c);
+            }
+        }
+    }
+    return result;
+}
+
+static std::string make_payload(const std::vector<std::string>& pieces, size_t size, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::string payload;
+    while (payload.size() < size) {
+        payload += pieces[gen() % pieces.size()];
+    }
+    return payload;
+}
+
+static void bench_payload(const char* name, std::string const& payload, int rounds)
+{
+    size_t total = 0;
+    std::string escaped;
+    double t_scalar = measure([&] {
+        for (int i = 0; i < rounds; i++) total += scalar_json_escape(payload).size();
+    });
+    double t_simd = measure([&] {
+        for (int i = 0; i < rounds; i++) { string_convert::json_escape(payload, escaped); total += escaped.size(); }
+    });
+    double t_valid = measure([&] {
+        for (int i = 0; i < rounds; i++) { string_convert::json_escape(payload, escaped, true); total += escaped.size(); }
+    });
+    std::vector<char> buffer(string_convert::json_escape_bound(payload.size()));
+    double t_buffer = measure([&] {
+        for (int i = 0; i < rounds; i++) total += string_convert::json_escape(payload.data(), payload.size(), &buffer[0]);
+    });
+    std::string unescaped;
+    double t_unescape = measure([&] {
+        for (int i = 0; i < rounds; i++) { string_convert::json_unescape(escaped, unescaped); total += unescaped.size(); }
+    });
+    double mb = payload.size() * rounds / 1e6;
+    printf("%-10s scalar %7.0f MB/s  escape %7.0f MB/s  escape+utf8 %7.0f MB/s  buffer %7.0f MB/s  unescape %7.0f MB/s  %s\n",
+           name, mb / t_scalar * 1e3, mb / t_simd * 1e3, mb / t_valid * 1e3, mb / t_buffer * 1e3,
+           mb / t_unescape * 1e3,
+           scalar_json_escape(payload) == escaped && unescaped == payload && total ? "" : "MISMATCH");
+}
+
+int main()
+{
+    const size_t size = 1 << 20;
+    const int rounds = 100;
+
+    // field values of a typical API response
+    bench_payload("records", make_payload({
+        "id", "2018-06-01T12:00:00Z", "user@example.com", "https://example.com/api/v1/items?page=2",
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit", "true", "12345.678",
+        "He said \"hello\"", "C:\\Program Files\\app", "line one\nline two\n" }, size, 1), rounds);
+
+    // log lines with tabs and newlines
+    bench_payload("logs", make_payload({
+        "2018-06-01 12:00:00.123\tINFO\trequest served in 12 ms\n",
+        "2018-06-01 12:00:00.456\tWARN\tslow query: SELECT * FROM \"users\" WHERE id = 7\n" }, size, 2), rounds);
+
+    // mostly non-ASCII text
+    bench_payload("cjk", make_payload({
+        u8"字符串实用函数库", u8"字符串编码转换库", u8"单个头文件，方便引用", u8"“引号”", " ", "\n" }, size, 3), rounds);
+
+    // escape heavy content
+    bench_payload("escapes", make_payload({ "\"", "\\", "\n", "\x01", "ab" }, size, 4), rounds / 10);
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+#include "string_utility.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <regex>
+#include <string>
+
+#ifndef _WINDOWS
+#include <fnmatch.h>
+#endif
+
+
+template <typename F>
+static double measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::vector<std::string> random_words(size_t count, size_t min_len, size_t max_len, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::vector<std::string> words(count);
+    for (auto& word : words)
+    {
+        word.resize(min_len + gen() % (max_len - min_len + 1));
+        for (auto& c : word)
+        {
+            c = static_cast<char>('a' + gen() % 26);
+        }
+    }
+    return words;
+}
+
+static size_t dp_edit_distance(std::string const& a, std::string const& b)
+{
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++)
+    {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= a.size(); i++)
+    {
+        size_t diag = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); j++)
+        {
+            size_t up = row[j];
+            row[j] = std::min(std::min(row[j], row[j - 1]) + 1, diag + (a[i - 1] != b[j - 1]));
+            diag = up;
+        }
+    }
+    return row[b.size()];
+}
+
+static void bench_edit_distance(size_t length, size_t pairs)
+{
+    auto left = random_words(pairs, length, length, 1);
+    auto right = random_words(pairs, length, length, 2);
+    size_t sum_dp = 0, sum_bit = 0;
+    double t_dp = measure([&] {
+        for (size_t i = 0; i < pairs; i++) sum_dp += dp_edit_distance(left[i], right[i]);
+    });
+    double t_bit = measure([&] {
+        for (size_t i = 0; i < pairs; i++) sum_bit += string_utility_a::edit_distance(left[i], right[i]);
+    });
+    printf("edit_distance len=%-5zu pairs=%-7zu dp %9.2f ms  bit-parallel %9.2f ms  %s\n",
+           length, pairs, t_dp, t_bit, sum_dp == sum_bit ? "" : "MISMATCH");
+}
+
+static void bench_fuzzy_find(size_t words, size_t max_distance)
+{
+    auto dictionary = random_words(words, 4, 16, 3);
+    std::string query = dictionary[words / 2];
+    query[1] = 'z';
+    size_t found_dp = 0;
+    double t_dp = measure([&] {
+        for (auto const& word : dictionary) found_dp += dp_edit_distance(query, word) <= max_distance;
+    });
+    size_t found_one = 0, found_all = 0;
+    double t_one = measure([&] {
+        found_one = string_utility_a::fuzzy_find(query, dictionary, max_distance).size();
+    });
+    double t_all = measure([&] {
+        found_all = string_utility_a::fuzzy_find(query, dictionary, max_distance, false, 0).size();
+    });
+    printf("fuzzy_find words=%-8zu k=%zu  dp %9.2f ms  1 thread %9.2f ms  all threads %9.2f ms  %s\n",
+           words, max_distance, t_dp, t_one, t_all,
+           found_dp == found_one && found_one == found_all ? "" : "MISMATCH");
+}
+
+static void bench_sort(const char* name, std::vector<std::string> const& input)
+{
+    auto by_std = input;
+    auto by_multikey = input;
+    auto by_parallel = input;
+    double t_std = measure([&] { std::sort(by_std.begin(), by_std.end()); });
+    double t_mkqs = measure([&] { string_utility_a::sort_strings(by_multikey); });
+    double t_par = measure([&] { string_utility_a::sort_strings(by_parallel, false, 0); });
+    printf("sort_strings %-14s n=%-8zu std::sort %9.2f ms  multikey %9.2f ms  parallel %9.2f ms  %s\n",
+           name, input.size(), t_std, t_mkqs, t_par,
+           by_std == by_multikey && by_std == by_parallel ? "" : "MISMATCH");
+}
+
+static void bench_sort_sizes(size_t n)
+{
+    bench_sort("random", random_words(n, 4, 16, 4));
+
+    // long shared prefixes, as produced by splitting paths or URLs
+    auto prefixed = random_words(n, 2, 8, 5);
+    for (auto& word : prefixed)
+    {
+        word = "/var/log/service/" + word;
+    }
+    bench_sort("shared prefix", prefixed);
+
+    // few distinct tokens, as produced by splitting natural text
+    auto dictionary = random_words(1000, 2, 10, 6);
+    std::mt19937 gen(7);
+    std::vector<std::string> repeated(n);
+    for (auto& word : repeated)
+    {
+        word = dictionary[gen() % dictionary.size()];
+    }
+    bench_sort("duplicates", repeated);
+}
+
+// translates the glob subset used below into an ECMAScript regex
+static std::string glob_to_regex(std::string const& glob)
+{
+    std::string result;
+    for (char c : glob)
+    {
+        switch (c)
+        {
+        case '*': result += ".*"; break;
+        case '?': result += "."; break;
+        case '[': case ']': case '-': result += c; break;
+        default:
+            if (!isalnum(static_cast<unsigned char>(c))) result += '\\';
+            result += c;
+        }
+    }
+    return result;
+}
+
+static void bench_glob(std::string const& pattern, std::vector<std::string> const& keys, bool ignore_case = false)
+{
+    size_t found_glob = 0, found_regex = 0, found_fnmatch = 0;
+    glob_pattern<std::string> glob(pattern, ignore_case);
+    double t_glob = measure([&] {
+        for (auto const& key : keys) found_glob += glob.match(key);
+    });
+    std::regex regex(glob_to_regex(pattern), ignore_case ? std::regex::icase : std::regex::ECMAScript);
+    double t_regex = measure([&] {
+        for (auto const& key : keys) found_regex += std::regex_match(key, regex);
+    });
+#ifndef _WINDOWS
+    double t_fnmatch = measure([&] {
+        for (auto const& key : keys) found_fnmatch += fnmatch(pattern.c_str(), key.c_str(), ignore_case ? FNM_CASEFOLD : 0) == 0;
+    });
+#else
+    double t_fnmatch = 0;
+    found_fnmatch = found_glob;
+#endif
+    printf("glob %-16s %s keys=%-8zu glob_pattern %8.2f ms  std::regex %9.2f ms  fnmatch %8.2f ms  %s\n",
+           pattern.c_str(), ignore_case ? "icase" : "     ", keys.size(), t_glob, t_regex, t_fnmatch,
+           found_glob == found_regex && found_glob == found_fnmatch ? "" : "MISMATCH");
+}
+
+static void bench_glob_set(std::vector<std::string> const& patterns, std::vector<std::string> const& keys)
+{
+    glob_set<std::string> set;
+    std::vector<glob_pattern<std::string>> each;
+    for (auto const& pattern : patterns)
+    {
+        set.add(pattern);
+        each.push_back(glob_pattern<std::string>(pattern));
+    }
+    size_t found_set = 0, found_each = 0;
+    double t_set = measure([&] {
+        for (auto const& key : keys) found_set += set.match_all(key).size();
+    });
+    double t_each = measure([&] {
+        for (auto const& key : keys)
+            for (auto const& glob : each) found_each += glob.match(key);
+    });
+    printf("glob_set patterns=%-5zu keys=%-8zu glob_set %8.2f ms  one by one %8.2f ms  %s\n",
+           patterns.size(), keys.size(), t_set, t_each, found_set == found_each ? "" : "MISMATCH");
+}
+
+static void bench_globs(size_t n)
+{
+    const char* suffixes[] = { ".log", ".txt", ".cpp", ".hpp", "" };
+    std::mt19937 gen(8);
+    auto keys = random_words(n, 4, 24, 9);
+    for (auto& key : keys)
+    {
+        if (gen() % 4 == 0) key = "user_" + key.substr(0, 2) + "_" + key;
+        key += suffixes[gen() % 5];
+    }
+    bench_glob("*.log", keys);
+    bench_glob("user_??_*", keys);
+    bench_glob("[a-f]*", keys);
+    bench_glob("*ab*cd*", keys);
+    bench_glob("*a?c*[x-z]*", keys);
+
+    // long keys with the interesting part in the middle
+    std::vector<std::string> lines = random_words(n / 4, 80, 160, 11);
+    for (size_t i = 0; i < lines.size(); i += 7)
+    {
+        lines[i].replace(lines[i].size() / 2, 5, "ERROR");
+    }
+    bench_glob("*error*", lines, true);
+    bench_glob("*e?ror*", lines);
+
+    std::vector<std::string> patterns = { "*.log", "*.txt", "user_??_*", "[a-f]*.cpp", "*ab*cd*" };
+    auto literals = random_words(200, 4, 12, 10);
+    for (size_t i = 0; i < literals.size(); i++)
+    {
+        patterns.push_back(i % 2 ? literals[i] + "*" : "*" + literals[i]);
+    }
+    bench_glob_set(patterns, keys);
+}
+
+int main()
+{
+    bench_edit_distance(8, 1000000);
+    bench_edit_distance(32, 200000);
+    bench_edit_distance(64, 100000);
+    bench_edit_distance(256, 5000);
+    bench_edit_distance(1024, 500);
+
+    bench_fuzzy_find(1000000, 1);
+    bench_fuzzy_find(1000000, 2);
+
+    bench_sort_sizes(10000);
+    bench_sort_sizes(100000);
+    bench_sort_sizes(1000000);
+
+    bench_globs(200000);
+
+    return 0;
+}
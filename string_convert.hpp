@@ -10,6 +10,14 @@
   #include <windows.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define STRING_CONVERT_SSE2
+  #include <emmintrin.h>
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #endif
+#endif
+
 #include <cstring>
 #include <locale>
 #include <codecvt>
@@ -439,4 +447,313 @@ struct string_convert
         return result;
     }
 
+    // worst case output size of json_escape for length input bytes
+    static size_t json_escape_bound(size_t length)
+    {
+        return length * 6;
+    }
+
+    // Escapes quotes, backslashes and control bytes for use inside a JSON
+    // string. With validate_utf8 the input is also checked to be well formed
+    // UTF-8, and false is returned if it is not.
+    static bool json_escape(std::string const& input, std::string& output, bool validate_utf8 = false)
+    {
+        output.clear();
+        output.reserve(input.size() + input.size() / 8 + 16);
+        const unsigned char* ptr = reinterpret_cast<const unsigned char*>(input.data());
+        return json_escape(ptr, ptr + input.size(), output, validate_utf8);
+    }
+
+    // Cannot fail: without UTF-8 validation every input has an escaped form.
+    static std::string json_escape(std::string const& str)
+    {
+        std::string result;
+        json_escape(str, result);
+        return result;
+    }
+
+    // Writes into a caller buffer of at least json_escape_bound(length) bytes.
+    // Returns the number of bytes written, or std::string::npos on invalid UTF-8.
+    static size_t json_escape(const char* input, size_t length, char* output, bool validate_utf8 = false)
+    {
+        json_buffer buffer = { output };
+        const unsigned char* ptr = reinterpret_cast<const unsigned char*>(input);
+        if (!json_escape(ptr, ptr + length, buffer, validate_utf8)) {
+            return std::string::npos;
+        }
+        return buffer.ptr - output;
+    }
+
+    // Decodes JSON string escapes, including \uXXXX surrogate pairs, to UTF-8.
+    // Returns false on a malformed escape or an unpaired surrogate.
+    static bool json_unescape(std::string const& input, std::string& output)
+    {
+        output.clear();
+        output.reserve(input.size());
+        return json_unescape(input.data(), input.data() + input.size(), output, false);
+    }
+
+    // Malformed escapes are left as they are in the result; use the overload
+    // returning bool to detect them.
+    static std::string json_unescape(std::string const& str)
+    {
+        std::string result;
+        result.reserve(str.size());
+        json_unescape(str.data(), str.data() + str.size(), result, true);
+        return result;
+    }
+
+    // Writes into a caller buffer of at least length bytes. Returns the number
+    // of bytes written, or std::string::npos on malformed input.
+    static size_t json_unescape(const char* input, size_t length, char* output)
+    {
+        json_buffer buffer = { output };
+        if (!json_unescape(input, input + length, buffer, false)) {
+            return std::string::npos;
+        }
+        return buffer.ptr - output;
+    }
+
+private:
+    struct json_buffer
+    {
+        char* ptr;
+
+        void append(const char* str, size_t length)
+        {
+            memcpy(ptr, str, length);
+            ptr += length;
+        }
+    };
+
+    static inline bool json_is_special(unsigned char c, bool check_utf8)
+    {
+        return c == '"' || c == '\\' || c < 0x20 || (check_utf8 && c >= 0x80);
+    }
+
+    // Returns the first byte from ptr on that cannot be copied as is: a quote,
+    // a backslash, a control byte, or with check_utf8 any non-ASCII byte.
+    static const unsigned char* json_scan(const unsigned char* ptr, const unsigned char* end_ptr, bool check_utf8)
+    {
+#ifdef STRING_CONVERT_SSE2
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control = _mm_set1_epi8(0x1f);
+        while (end_ptr - ptr >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+            __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+            int mask = _mm_movemask_epi8(special);
+            if (check_utf8) {
+                mask |= _mm_movemask_epi8(chunk);   // high bit set
+            }
+            if (mask != 0) {
+#ifdef _MSC_VER
+                unsigned long index;
+                _BitScanForward(&index, mask);
+                return ptr + index;
+#else
+                return ptr + __builtin_ctz(mask);
+#endif
+            }
+            ptr += 16;
+        }
+#endif
+        while (ptr < end_ptr && !json_is_special(*ptr, check_utf8)) {
+            ++ptr;
+        }
+        return ptr;
+    }
+
+    // length of the well formed UTF-8 sequence at ptr, or 0
+    // see http://www.unicode.org/versions/Unicode6.0.0/ch03.pdf table 3-7
+    static size_t utf8_sequence_length(const unsigned char* ptr, const unsigned char* end_ptr)
+    {
+        size_t avail = end_ptr - ptr;
+        unsigned char lead = ptr[0];
+        if (lead < 0x80) {
+            return 1;
+        }
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            return (avail >= 2 && (ptr[1] & 0xC0) == 0x80) ? 2 : 0;
+        }
+        if (lead >= 0xE0 && lead <= 0xEF) {
+            unsigned char lo = lead == 0xE0 ? 0xA0 : 0x80;
+            unsigned char hi = lead == 0xED ? 0x9F : 0xBF;
+            return (avail >= 3 && ptr[1] >= lo && ptr[1] <= hi && (ptr[2] & 0xC0) == 0x80) ? 3 : 0;
+        }
+        if (lead >= 0xF0 && lead <= 0xF4) {
+            unsigned char lo = lead == 0xF0 ? 0x90 : 0x80;
+            unsigned char hi = lead == 0xF4 ? 0x8F : 0xBF;
+            return (avail >= 4 && ptr[1] >= lo && ptr[1] <= hi
+                && (ptr[2] & 0xC0) == 0x80 && (ptr[3] & 0xC0) == 0x80) ? 4 : 0;
+        }
+        return 0;
+    }
+
+    template <typename Output>
+    static bool json_escape(const unsigned char* ptr, const unsigned char* end_ptr, Output& output, bool validate_utf8)
+    {
+        static const char hex_digits[] = "0123456789abcdef";
+        while (ptr < end_ptr) {
+            // copy the run of plain characters in one go
+            if (!json_is_special(*ptr, validate_utf8)) {
+                const unsigned char* run_end = json_scan(ptr, end_ptr, validate_utf8);
+                output.append(reinterpret_cast<const char*>(ptr), run_end - ptr);
+                ptr = run_end;
+                if (ptr == end_ptr) {
+                    break;
+                }
+            }
+            if (*ptr >= 0x80) {
+                // validate the whole run of non-ASCII characters, then copy it
+                const unsigned char* run_begin = ptr;
+                while (ptr < end_ptr && *ptr >= 0x80) {
+                    size_t length = utf8_sequence_length(ptr, end_ptr);
+                    if (length == 0) {
+                        return false;
+                    }
+                    ptr += length;
+                }
+                output.append(reinterpret_cast<const char*>(run_begin), ptr - run_begin);
+                continue;
+            }
+            char escape[6] = { '\\', 0, '0', '0', 0, 0 };
+            size_t length = 2;
+            switch (*ptr) {
+            case '"':  escape[1] = '"'; break;
+            case '\\': escape[1] = '\\'; break;
+            case '\b': escape[1] = 'b'; break;
+            case '\f': escape[1] = 'f'; break;
+            case '\n': escape[1] = 'n'; break;
+            case '\r': escape[1] = 'r'; break;
+            case '\t': escape[1] = 't'; break;
+            default:
+                escape[1] = 'u';
+                escape[4] = hex_digits[*ptr >> 4];
+                escape[5] = hex_digits[*ptr & 0xf];
+                length = 6;
+            }
+            output.append(escape, length);
+            ++ptr;
+        }
+        return true;
+    }
+
+    static bool json_read_hex4(const char* ptr, const char* end_ptr, unsigned int& value)
+    {
+        if (end_ptr - ptr < 4) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = ptr[i];
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                value |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                value |= c - 'A' + 10;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Decodes the escape after a backslash at ptr. On success appends it and
+    // moves ptr past it; on failure leaves both untouched.
+    template <typename Output>
+    static bool json_decode_escape(const char*& ptr, const char* end_ptr, Output& output)
+    {
+        const char* cursor = ptr;
+        if (cursor == end_ptr) {
+            return false;
+        }
+        char c = *cursor++;
+        switch (c) {
+        case '"': case '\\': case '/':
+            break;
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'u': {
+            unsigned int code_point;
+            if (!json_read_hex4(cursor, end_ptr, code_point)) {
+                return false;
+            }
+            cursor += 4;
+            if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+                return false;
+            }
+            if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+                // high surrogate, must be followed by \u low surrogate
+                unsigned int low;
+                if (end_ptr - cursor < 6 || cursor[0] != '\\' || cursor[1] != 'u'
+                    || !json_read_hex4(cursor + 2, end_ptr, low) || low < 0xDC00 || low > 0xDFFF) {
+                    return false;
+                }
+                cursor += 6;
+                code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+            }
+            char utf8[4];
+            size_t length;
+            if (code_point < 0x80) {
+                utf8[0] = static_cast<char>(code_point);
+                length = 1;
+            } else if (code_point < 0x800) {
+                utf8[0] = static_cast<char>(0xC0 | (code_point >> 6));
+                utf8[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+                length = 2;
+            } else if (code_point < 0x10000) {
+                utf8[0] = static_cast<char>(0xE0 | (code_point >> 12));
+                utf8[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                utf8[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+                length = 3;
+            } else {
+                utf8[0] = static_cast<char>(0xF0 | (code_point >> 18));
+                utf8[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+                utf8[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                utf8[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+                length = 4;
+            }
+            output.append(utf8, length);
+            ptr = cursor;
+            return true;
+        }
+        default:
+            return false;
+        }
+        output.append(&c, 1);
+        ptr = cursor;
+        return true;
+    }
+
+    // With recover, a malformed escape is copied through unchanged instead of
+    // failing, the way url_decode recovers by not decoding.
+    template <typename Output>
+    static bool json_unescape(const char* ptr, const char* end_ptr, Output& output, bool recover)
+    {
+        while (ptr < end_ptr) {
+            const char* slash = static_cast<const char*>(memchr(ptr, '\\', end_ptr - ptr));
+            if (slash == nullptr) {
+                output.append(ptr, end_ptr - ptr);
+                break;
+            }
+            output.append(ptr, slash - ptr);
+            ptr = slash + 1;
+            if (!json_decode_escape(ptr, end_ptr, output)) {
+                if (!recover) {
+                    return false;
+                }
+                output.append(slash, 1);
+            }
+        }
+        return true;
+    }
+
 };
@@ -2,10 +2,22 @@
 #pragma once
 
 #include <cstring>
+#include <cstdint>
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
 #include <vector>
+#include <iterator>
+#include <unordered_map>
+#include <thread>
+#include <type_traits>
+
+// same folding as string_utility::to_lower, applied to a single character
+template <typename Ch>
+inline Ch fold_case(Ch c)
+{
+    return static_cast<Ch>(::tolower(c));
+}
 
 template <typename Str>
 struct tokenizer
@@ -59,9 +71,1228 @@ struct tokenizer
     Str _delimiters;
 };
 
+// Levenshtein distance against a fixed pattern, computed with the bit-parallel
+// algorithm of Myers (1999) in the multi-word block form given by Hyyro (2003).
+// The pattern is compiled once and can be matched against many texts.
+template <typename Str>
+struct levenshtein_pattern
+{
+    typedef typename Str::value_type char_type;
+    typedef typename std::make_unsigned<char_type>::type uchar_type;
+
+    levenshtein_pattern(Str const& pattern, bool ignore_case = false)
+        : _length(pattern.size()), _blocks((pattern.size() + 63) / 64),
+          _ignore_case(ignore_case), _zeros(_blocks, 0)
+    {
+        if (sizeof(char_type) == 1)
+        {
+            _table.assign(256 * _blocks, 0);
+        }
+        for (size_t i = 0; i < _length; i++)
+        {
+            mutable_row(fold(pattern[i]))[i / 64] |= uint64_t(1) << (i % 64);
+        }
+        std::fill(_qgrams, _qgrams + 4, 0);
+        for (size_t i = 1; i < _length; i++)
+        {
+            size_t h = qgram_hash(fold(pattern[i - 1]), fold(pattern[i]));
+            _qgrams[h / 64] |= uint64_t(1) << (h % 64);
+        }
+    }
+
+    size_t length() const
+    {
+        return _length;
+    }
+
+    // Cheap necessary condition for distance(text) <= max_distance, using the
+    // length difference and the count of text bigrams also seen in the pattern.
+    bool may_match(Str const& text, size_t max_distance) const
+    {
+        size_t n = text.size();
+        size_t diff = _length > n ? _length - n : n - _length;
+        if (diff > max_distance)
+        {
+            return false;
+        }
+        // every edit destroys at most two bigrams of the text
+        if (max_distance >= n / 2)
+        {
+            return true;
+        }
+        size_t required = n - 1 - 2 * max_distance;
+        size_t shared = 0;
+        for (size_t i = 1; i < n && shared < required; i++)
+        {
+            size_t h = qgram_hash(fold(text[i - 1]), fold(text[i]));
+            if (_qgrams[h / 64] & (uint64_t(1) << (h % 64)))
+            {
+                shared++;
+            }
+        }
+        return shared >= required;
+    }
+
+    // Returns the edit distance, or max_distance + 1 as soon as it is known
+    // to exceed max_distance.
+    size_t distance(Str const& text, size_t max_distance = size_t(-1)) const
+    {
+        size_t m = _length;
+        size_t n = text.size();
+        size_t diff = m > n ? m - n : n - m;
+        if (diff > max_distance)
+        {
+            return max_distance + 1;
+        }
+        if (m == 0 || n == 0)
+        {
+            return diff;
+        }
+        if (_blocks == 1)
+        {
+            return distance_word([this](char_type c) { return row(c)[0]; }, m, text, _ignore_case, max_distance);
+        }
+        return distance_blocks(text, max_distance);
+    }
+
+    // One-off distance for patterns of at most 64 characters, without
+    // building a reusable table on the heap. Wide character texts longer than
+    // 256 characters go through a compiled pattern instead.
+    static size_t distance_once(Str const& pattern, Str const& text, bool ignore_case = false,
+                                size_t max_distance = size_t(-1))
+    {
+        size_t m = pattern.size();
+        size_t n = text.size();
+        size_t diff = m > n ? m - n : n - m;
+        if (diff > max_distance)
+        {
+            return max_distance + 1;
+        }
+        if (m == 0 || n == 0)
+        {
+            return diff;
+        }
+        if (sizeof(char_type) == 1)
+        {
+            // all zero between calls: only the pattern's entries are set,
+            // and they are cleared again before returning
+            static thread_local uint64_t table[256];
+            for (size_t i = 0; i < m; i++)
+            {
+                table[static_cast<uchar_type>(ignore_case ? fold_case(pattern[i]) : pattern[i])] |= uint64_t(1) << i;
+            }
+            size_t d = distance_word([](char_type c) { return table[static_cast<uchar_type>(c)]; },
+                                     m, text, ignore_case, max_distance);
+            for (size_t i = 0; i < m; i++)
+            {
+                table[static_cast<uchar_type>(ignore_case ? fold_case(pattern[i]) : pattern[i])] = 0;
+            }
+            return d;
+        }
+        if (n > 256)
+        {
+            return levenshtein_pattern(pattern, ignore_case).distance(text, max_distance);
+        }
+        word_table peq(pattern, text, ignore_case);
+        return distance_word(peq, m, text, ignore_case, max_distance);
+    }
+
+private:
+    char_type fold(char_type c) const
+    {
+        return _ignore_case ? fold_case(c) : c;
+    }
+
+    static size_t qgram_hash(char_type a, char_type b)
+    {
+        return (static_cast<size_t>(static_cast<uchar_type>(a)) * 31
+            + static_cast<size_t>(static_cast<uchar_type>(b))) & 255;
+    }
+
+    uint64_t* mutable_row(char_type c)
+    {
+        if (sizeof(char_type) == 1)
+        {
+            return &_table[static_cast<uchar_type>(c) * _blocks];
+        }
+        std::vector<uint64_t>& row = _wide_table[c];
+        if (row.empty())
+        {
+            row.assign(_blocks, 0);
+        }
+        return &row[0];
+    }
+
+    const uint64_t* row(char_type c) const
+    {
+        if (sizeof(char_type) == 1)
+        {
+            return &_table[static_cast<uchar_type>(c) * _blocks];
+        }
+        auto it = _wide_table.find(c);
+        return it == _wide_table.end() ? &_zeros[0] : &it->second[0];
+    }
+
+    // match masks of a pattern of at most 64 wide characters, kept on the
+    // stack; only the slots of characters in the pattern or the text are
+    // initialized, so the text must have at most 256 characters
+    struct word_table
+    {
+        word_table(Str const& pattern, Str const& text, bool ignore_case)
+        {
+            std::fill(_used, _used + 8, 0);
+            for (size_t i = 0; i < pattern.size(); i++)
+            {
+                _masks[insert(ignore_case ? fold_case(pattern[i]) : pattern[i])] |= uint64_t(1) << i;
+            }
+            for (size_t j = 0; j < text.size(); j++)
+            {
+                insert(ignore_case ? fold_case(text[j]) : text[j]);
+            }
+        }
+
+        // only valid for characters seen by the constructor
+        uint64_t operator()(char_type c) const
+        {
+            return _masks[find_slot(c)];
+        }
+
+    private:
+        bool is_used(size_t slot) const
+        {
+            return (_used[slot / 64] >> (slot % 64)) & 1;
+        }
+
+        size_t insert(char_type c)
+        {
+            size_t slot = find_slot(c);
+            if (!is_used(slot))
+            {
+                _used[slot / 64] |= uint64_t(1) << (slot % 64);
+                _keys[slot] = c;
+                _masks[slot] = 0;
+            }
+            return slot;
+        }
+
+        // linear probing, at most 320 of the slots are taken
+        size_t find_slot(char_type c) const
+        {
+            size_t slot = (static_cast<size_t>(static_cast<uchar_type>(c)) * 2654435761u) & (slots - 1);
+            while (is_used(slot) && _keys[slot] != c)
+            {
+                slot = (slot + 1) & (slots - 1);
+            }
+            return slot;
+        }
+
+        static const size_t slots = 512;
+
+        uint64_t _used[slots / 64];
+        char_type _keys[slots];
+        uint64_t _masks[slots];
+    };
+
+    template <typename Peq>
+    static size_t distance_word(Peq const& peq, size_t length, Str const& text, bool ignore_case,
+                                size_t max_distance)
+    {
+        size_t n = text.size();
+        uint64_t vp = ~uint64_t(0);
+        uint64_t vn = 0;
+        uint64_t last = uint64_t(1) << (length - 1);
+        size_t score = length;
+        for (size_t j = 0; j < n; j++)
+        {
+            uint64_t eq = peq(ignore_case ? fold_case(text[j]) : text[j]);
+            uint64_t xv = eq | vn;
+            uint64_t xh = (((eq & vp) + vp) ^ vp) | eq;
+            uint64_t hp = vn | ~(xh | vp);
+            uint64_t hn = vp & xh;
+            if (hp & last)
+            {
+                score++;
+            }
+            else if (hn & last)
+            {
+                score--;
+            }
+            hp = (hp << 1) | 1;
+            hn <<= 1;
+            vp = hn | ~(xv | hp);
+            vn = hp & xv;
+            // the score can drop by at most one per remaining column
+            if (score > max_distance && score - max_distance > n - j - 1)
+            {
+                return max_distance + 1;
+            }
+        }
+        return score;
+    }
+
+    size_t distance_blocks(Str const& text, size_t max_distance) const
+    {
+        size_t n = text.size();
+        std::vector<uint64_t> vp(_blocks, ~uint64_t(0));
+        std::vector<uint64_t> vn(_blocks, 0);
+        const uint64_t high = uint64_t(1) << 63;
+        const uint64_t last = uint64_t(1) << ((_length - 1) % 64);
+        size_t score = _length;
+        for (size_t j = 0; j < n; j++)
+        {
+            const uint64_t* eqs = row(fold(text[j]));
+            int hin = 1;
+            for (size_t b = 0; b < _blocks; b++)
+            {
+                uint64_t eq = eqs[b];
+                uint64_t pv = vp[b];
+                uint64_t mv = vn[b];
+                uint64_t xv = eq | mv;
+                if (hin < 0)
+                {
+                    eq |= 1;
+                }
+                uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+                uint64_t hp = mv | ~(xh | pv);
+                uint64_t hn = pv & xh;
+                uint64_t out = b + 1 == _blocks ? last : high;
+                int hout = (hp & out) ? 1 : ((hn & out) ? -1 : 0);
+                hp <<= 1;
+                hn <<= 1;
+                if (hin < 0)
+                {
+                    hn |= 1;
+                }
+                else if (hin > 0)
+                {
+                    hp |= 1;
+                }
+                vp[b] = hn | ~(xv | hp);
+                vn[b] = hp & xv;
+                hin = hout;
+            }
+            score += hin;
+            if (score > max_distance && score - max_distance > n - j - 1)
+            {
+                return max_distance + 1;
+            }
+        }
+        return score;
+    }
+
+    size_t _length;
+    size_t _blocks;
+    bool _ignore_case;
+    std::vector<uint64_t> _zeros;
+    std::vector<uint64_t> _table;
+    std::unordered_map<char_type, std::vector<uint64_t>> _wide_table;
+    uint64_t _qgrams[4];
+};
+
+// Sorts strings with multikey quicksort over cached 64-bit key prefixes
+// (Bentley & Sedgewick, with the caching of Karkkainen & Rantala): most
+// comparisons touch only the cached key, and the string data is read again
+// only when a group of equal keys moves on to its next prefix. Equal strings
+// keep their input order. The element type needs data() and size(), so spans
+// of string views work as well.
+template <typename Str>
+struct string_sorter
+{
+    typedef typename Str::value_type char_type;
+    typedef typename std::make_unsigned<char_type>::type uchar_type;
+
+    static_assert(sizeof(char_type) <= 4, "character type too wide for key prefixes");
+
+    string_sorter(bool ignore_case = false)
+        : _ignore_case(ignore_case)
+    {}
+
+    template <typename It>
+    void sort(It first, It last, unsigned threads = 1) const
+    {
+        typedef typename std::iterator_traits<It>::value_type value_type;
+        size_t n = static_cast<size_t>(last - first);
+        std::vector<entry> entries(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            entries[i].data = first[i].data();
+            entries[i].size = first[i].size();
+            entries[i].index = i;
+            load_key(entries[i], 0);
+        }
+        if (n < 2)
+        {
+            return;
+        }
+        sort_range(&entries[0], &entries[0] + n, 0, threads, depth_budget(n));
+
+        std::vector<value_type> sorted;
+        sorted.reserve(n);
+        for (auto const& e : entries)
+        {
+            sorted.push_back(std::move(first[e.index]));
+        }
+        std::move(sorted.begin(), sorted.end(), first);
+    }
+
+    template <typename T>
+    bool equal(T const& a, T const& b) const
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (code(a.data()[i]) != code(b.data()[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct entry
+    {
+        uint64_t key;
+        const char_type* data;
+        size_t size;
+        size_t index;
+    };
+
+    static const size_t key_chars = sizeof(uint64_t) / sizeof(char_type);
+    static const size_t insertion_threshold = 16;
+    static const size_t parallel_threshold = 1 << 14;
+
+    // character order of std::char_traits, after optional case folding
+    uint64_t code(char_type c) const
+    {
+        uchar_type u = static_cast<uchar_type>(_ignore_case ? fold_case(c) : c);
+        if (sizeof(char_type) > 1 && std::is_signed<char_type>::value)
+        {
+            u ^= static_cast<uchar_type>(uchar_type(1) << (sizeof(char_type) * 8 - 1));
+        }
+        return u;
+    }
+
+    void load_key(entry& e, size_t depth) const
+    {
+        uint64_t key = 0;
+        for (size_t i = depth; i < depth + key_chars; i++)
+        {
+            key <<= sizeof(char_type) * 8;
+            if (i < e.size)
+            {
+                key |= code(e.data[i]);
+            }
+        }
+        e.key = key;
+    }
+
+    // equal keys at depth mean the strings agree up to depth + key_chars,
+    // except that the shorter one may already have ended there
+    bool less(entry const& a, entry const& b, size_t depth) const
+    {
+        if (a.key != b.key)
+        {
+            return a.key < b.key;
+        }
+        for (size_t i = depth + key_chars; ; i++)
+        {
+            if (i >= a.size || i >= b.size)
+            {
+                return a.size != b.size ? a.size < b.size : a.index < b.index;
+            }
+            uint64_t ca = code(a.data[i]);
+            uint64_t cb = code(b.data[i]);
+            if (ca != cb)
+            {
+                return ca < cb;
+            }
+        }
+    }
+
+    static uint64_t median3(uint64_t a, uint64_t b, uint64_t c)
+    {
+        return std::max(std::min(a, b), std::min(std::max(a, b), c));
+    }
+
+    // Tukey's ninther for larger ranges, median of three otherwise
+    static uint64_t median_key(entry const* lo, entry const* hi)
+    {
+        size_t n = static_cast<size_t>(hi - lo);
+        if (n < 128)
+        {
+            return median3(lo->key, lo[n / 2].key, hi[-1].key);
+        }
+        size_t step = n / 8;
+        return median3(median3(lo[0].key, lo[step].key, lo[2 * step].key),
+                       median3(lo[3 * step].key, lo[4 * step].key, lo[5 * step].key),
+                       median3(lo[6 * step].key, lo[7 * step].key, hi[-1].key));
+    }
+
+    // partitions allowed before falling back to std::sort, as in introsort
+    static unsigned depth_budget(size_t n)
+    {
+        unsigned budget = 0;
+        for (; n > 1; n >>= 1)
+        {
+            budget += 2;
+        }
+        return budget;
+    }
+
+    struct part
+    {
+        entry* lo;
+        entry* hi;
+        size_t depth;
+
+        size_t size() const
+        {
+            return static_cast<size_t>(hi - lo);
+        }
+    };
+
+    // Each round splits the range into the keys below, equal to and above
+    // the pivot. The two smaller parts are sorted by recursion (or by worker
+    // threads) and the loop continues on the largest, so the stack stays
+    // O(log n) deep.
+    void sort_range(entry* lo, entry* hi, size_t depth, unsigned threads, unsigned budget) const
+    {
+        std::vector<std::thread> workers;
+        while (static_cast<size_t>(hi - lo) > insertion_threshold)
+        {
+            if (budget == 0)
+            {
+                std::sort(lo, hi, [this, depth](entry const& a, entry const& b) { return less(a, b, depth); });
+                lo = hi;
+                break;
+            }
+            budget--;
+
+            uint64_t pivot = median_key(lo, hi);
+            entry* lt = lo;
+            entry* gt = hi;
+            for (entry* i = lo; i < gt; )
+            {
+                if (i->key < pivot)
+                {
+                    std::swap(*lt++, *i++);
+                }
+                else if (i->key > pivot)
+                {
+                    std::swap(*i, *--gt);
+                }
+                else
+                {
+                    i++;
+                }
+            }
+
+            // strings that ended inside this key are prefixes of the rest of
+            // the equal part, which moves on to the next key
+            size_t limit = depth + key_chars;
+            entry* mid = std::partition(lt, gt, [limit](entry const& e) { return e.size <= limit; });
+            std::sort(lt, mid, [](entry const& a, entry const& b)
+                { return a.size != b.size ? a.size < b.size : a.index < b.index; });
+            for (entry* e = mid; e < gt; e++)
+            {
+                load_key(*e, limit);
+            }
+
+            size_t n = static_cast<size_t>(hi - lo);
+            part parts[3] = { { lo, lt, depth }, { mid, gt, limit }, { gt, hi, depth } };
+            std::sort(parts, parts + 3, [](part const& a, part const& b) { return a.size() < b.size(); });
+
+            // split the thread budget by size; this thread keeps at least one
+            // for the largest part, and a part with no share is sorted inline
+            unsigned shares[2] = { 0, 0 };
+            if (threads > 1 && n >= parallel_threshold)
+            {
+                for (int k = 0; k < 2; k++)
+                {
+                    shares[k] = parts[k].size() > 1 ? static_cast<unsigned>(threads * parts[k].size() / n) : 0;
+                }
+                if (shares[0] + shares[1] >= threads)
+                {
+                    shares[1]--;
+                }
+            }
+            for (int k = 0; k < 2; k++)
+            {
+                part const& p = parts[k];
+                // the equal part starts over with a fresh budget at its new depth
+                unsigned part_budget = p.depth == depth ? budget : depth_budget(p.size());
+                if (shares[k] > 0)
+                {
+                    workers.push_back(std::thread(&string_sorter::sort_range, this,
+                                                  p.lo, p.hi, p.depth, shares[k], part_budget));
+                }
+                else if (p.size() > 1)
+                {
+                    sort_range(p.lo, p.hi, p.depth, 1, part_budget);
+                }
+            }
+            threads -= shares[0] + shares[1];
+            if (parts[2].depth != depth)
+            {
+                budget = depth_budget(parts[2].size());
+            }
+            lo = parts[2].lo;
+            hi = parts[2].hi;
+            depth = parts[2].depth;
+        }
+
+        for (entry* i = lo + (lo < hi); i < hi; i++)
+        {
+            entry temp = *i;
+            entry* j = i;
+            for (; j > lo && less(temp, j[-1], depth); j--)
+            {
+                *j = j[-1];
+            }
+            *j = temp;
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    bool _ignore_case;
+};
+
+// Shell style wildcard pattern (*, ?, [a-f], [!a-f], \ escapes) compiled once
+// for repeated matching. The pattern is split at each '*' into segments: the
+// first must match at the start, the last at the end, and the ones in between
+// are searched for left to right, taking the leftmost occurrence. That choice
+// is always safe, so matching never backtracks. Inner segments are searched
+// with memmem when they are case sensitive literals, and otherwise with a
+// Shift-And bitmask (up to 64 atoms), which handles ?, classes and folded
+// literals in one linear pass.
+template <typename Str>
+struct glob_pattern
+{
+    typedef typename Str::value_type char_type;
+    typedef typename Str::traits_type traits_type;
+    typedef typename std::make_unsigned<char_type>::type uchar_type;
+
+    glob_pattern(Str const& pattern, bool ignore_case = false)
+        : _ignore_case(ignore_case), _has_star(false), _min_length(0)
+    {
+        _segments.push_back(segment());
+        for (size_t i = 0; i < pattern.size(); i++)
+        {
+            char_type c = pattern[i];
+            if (c == '*')
+            {
+                while (i + 1 < pattern.size() && pattern[i + 1] == '*')
+                {
+                    i++;
+                }
+                _has_star = true;
+                _segments.push_back(segment());
+                continue;
+            }
+            atom a = { atom::literal, c, 0 };
+            if (c == '?')
+            {
+                a.type = atom::any;
+            }
+            else if (c == '[')
+            {
+                size_t end = parse_class(pattern, i + 1);
+                if (end != Str::npos)
+                {
+                    a.type = atom::set;
+                    a.class_index = _classes.size() - 1;
+                    i = end;
+                }
+            }
+            else if (c == '\\' && i + 1 < pattern.size())
+            {
+                a.ch = pattern[++i];
+            }
+            if (a.type == atom::literal)
+            {
+                a.ch = fold(a.ch);
+                _segments.back().text.push_back(a.ch);
+            }
+            else
+            {
+                _segments.back().literal = false;
+            }
+            _segments.back().atoms.push_back(a);
+        }
+        for (size_t i = 0; i < _segments.size(); i++)
+        {
+            _min_length += _segments[i].atoms.size();
+            if (i > 0 && i + 1 < _segments.size())
+            {
+                compile_shift_and(_segments[i]);
+            }
+        }
+    }
+
+    bool has_wildcards() const
+    {
+        return _has_star || !_segments[0].literal;
+    }
+
+    // the literal text that every match starts with when the pattern is "lit*",
+    // or equals when the pattern has no wildcards at all
+    bool literal_prefix(Str& prefix) const
+    {
+        if (_segments.size() > 2 || !_segments[0].literal || (_has_star && !_segments[1].atoms.empty()))
+        {
+            return false;
+        }
+        prefix = _segments[0].text;
+        return true;
+    }
+
+    // the literal text that every match ends with when the pattern is "*lit"
+    bool literal_suffix(Str& suffix) const
+    {
+        if (_segments.size() != 2 || !_segments[0].atoms.empty() || !_segments[1].literal)
+        {
+            return false;
+        }
+        suffix = _segments[1].text;
+        return true;
+    }
+
+    size_t min_length() const
+    {
+        return _min_length;
+    }
+
+    bool ignore_case() const
+    {
+        return _ignore_case;
+    }
+
+    bool match(Str const& value) const
+    {
+        if (!_has_star)
+        {
+            return value.size() == _min_length && match_at(_segments[0], value, 0);
+        }
+        if (value.size() < _min_length)
+        {
+            return false;
+        }
+        segment const& first = _segments.front();
+        segment const& last = _segments.back();
+        size_t end = value.size() - last.atoms.size();
+        if (!match_at(first, value, 0) || !match_at(last, value, end))
+        {
+            return false;
+        }
+        size_t pos = first.atoms.size();
+        for (size_t i = 1; i + 1 < _segments.size(); i++)
+        {
+            pos = find(_segments[i], value, pos, end);
+            if (pos == Str::npos)
+            {
+                return false;
+            }
+            pos += _segments[i].atoms.size();
+        }
+        return true;
+    }
+
+private:
+    struct atom
+    {
+        enum kind { literal, any, set };
+        kind type;
+        char_type ch;
+        size_t class_index;
+    };
+
+    struct segment
+    {
+        segment() : literal(true), shift_and(false), any_mask(0) {}
+
+        std::vector<atom> atoms;
+        Str text;       // the atoms as a string when they are all literals
+        bool literal;
+
+        // Shift-And masks for inner segments of up to 64 atoms that cannot be
+        // searched as plain text: bit k is set when atom k accepts the char
+        bool shift_and;
+        std::vector<uint64_t> masks;                    // single byte chars
+        uint64_t any_mask;                              // wide chars from here on
+        std::unordered_map<char_type, uint64_t> literal_masks;
+        std::vector<std::pair<size_t, uint64_t>> class_masks;
+    };
+
+    struct char_class
+    {
+        bool negate;
+        std::vector<std::pair<char_type, char_type>> ranges;
+    };
+
+    char_type fold(char_type c) const
+    {
+        return _ignore_case ? fold_case(c) : c;
+    }
+
+    // parses the body of [...] starting after '[', returns the index of ']'
+    size_t parse_class(Str const& pattern, size_t i)
+    {
+        char_class cls;
+        cls.negate = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+        if (cls.negate)
+        {
+            i++;
+        }
+        size_t first = i;
+        for (; i < pattern.size(); i++)
+        {
+            char_type c = pattern[i];
+            if (c == ']' && i > first)
+            {
+                _classes.push_back(cls);
+                return i;
+            }
+            if (c == '\\' && i + 1 < pattern.size())
+            {
+                c = pattern[++i];
+            }
+            char_type hi = c;
+            if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']')
+            {
+                i += 2;
+                hi = pattern[i];
+                if (hi == '\\' && i + 1 < pattern.size())
+                {
+                    hi = pattern[++i];
+                }
+            }
+            cls.ranges.push_back(std::make_pair(c, hi));
+        }
+        return Str::npos;
+    }
+
+    bool in_class(char_class const& cls, char_type c) const
+    {
+        bool found = false;
+        for (auto const& range : cls.ranges)
+        {
+            if ((c >= range.first && c <= range.second)
+                || (_ignore_case && ((fold_case(c) >= range.first && fold_case(c) <= range.second)
+                    || (static_cast<char_type>(::toupper(c)) >= range.first
+                        && static_cast<char_type>(::toupper(c)) <= range.second))))
+            {
+                found = true;
+                break;
+            }
+        }
+        return found != cls.negate;
+    }
+
+    bool match_at(segment const& seg, Str const& value, size_t pos) const
+    {
+        if (seg.literal && !_ignore_case)
+        {
+            return traits_type::compare(value.data() + pos, seg.text.data(), seg.text.size()) == 0;
+        }
+        for (size_t k = 0; k < seg.atoms.size(); k++)
+        {
+            atom const& a = seg.atoms[k];
+            char_type c = value[pos + k];
+            if ((a.type == atom::literal && fold(c) != a.ch)
+                || (a.type == atom::set && !in_class(_classes[a.class_index], c)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool accepts(atom const& a, char_type c) const
+    {
+        switch (a.type)
+        {
+        case atom::literal:
+            return fold(c) == a.ch;
+        case atom::set:
+            return in_class(_classes[a.class_index], c);
+        default:
+            return true;
+        }
+    }
+
+    void compile_shift_and(segment& seg) const
+    {
+        if (seg.atoms.empty() || seg.atoms.size() > 64 || (seg.literal && !_ignore_case))
+        {
+            return;
+        }
+        seg.shift_and = true;
+        if (sizeof(char_type) == 1)
+        {
+            seg.masks.assign(256, 0);
+            for (size_t c = 0; c < 256; c++)
+            {
+                for (size_t k = 0; k < seg.atoms.size(); k++)
+                {
+                    if (accepts(seg.atoms[k], static_cast<char_type>(c)))
+                    {
+                        seg.masks[c] |= uint64_t(1) << k;
+                    }
+                }
+            }
+            return;
+        }
+        for (size_t k = 0; k < seg.atoms.size(); k++)
+        {
+            atom const& a = seg.atoms[k];
+            uint64_t bit = uint64_t(1) << k;
+            if (a.type == atom::any)
+            {
+                seg.any_mask |= bit;
+            }
+            else if (a.type == atom::literal)
+            {
+                seg.literal_masks[a.ch] |= bit;
+            }
+            else
+            {
+                seg.class_masks.push_back(std::make_pair(a.class_index, bit));
+            }
+        }
+    }
+
+    uint64_t char_mask(segment const& seg, char_type c) const
+    {
+        if (sizeof(char_type) == 1)
+        {
+            return seg.masks[static_cast<uchar_type>(c)];
+        }
+        uint64_t mask = seg.any_mask;
+        auto it = seg.literal_masks.find(fold(c));
+        if (it != seg.literal_masks.end())
+        {
+            mask |= it->second;
+        }
+        for (auto const& cm : seg.class_masks)
+        {
+            if (in_class(_classes[cm.first], c))
+            {
+                mask |= cm.second;
+            }
+        }
+        return mask;
+    }
+
+    // leftmost position in [pos, end) where seg matches entirely before end
+    size_t find(segment const& seg, Str const& value, size_t pos, size_t end) const
+    {
+        size_t length = seg.atoms.size();
+        if (end < pos + length)
+        {
+            return Str::npos;
+        }
+        if (seg.literal && !_ignore_case)
+        {
+#ifdef __GLIBC__
+            if (sizeof(char_type) == 1)
+            {
+                const void* found = memmem(value.data() + pos, end - pos, seg.text.data(), length);
+                return found ? static_cast<const char_type*>(found) - value.data() : Str::npos;
+            }
+#endif
+            size_t found = value.find(seg.text, pos);
+            return found != Str::npos && found + length <= end ? found : Str::npos;
+        }
+        if (seg.shift_and)
+        {
+            // one pass: bit k of state is set when the last k + 1 characters
+            // match the first k + 1 atoms
+            uint64_t state = 0;
+            uint64_t found = uint64_t(1) << (length - 1);
+            for (size_t i = pos; i < end; i++)
+            {
+                state = ((state << 1) | 1) & char_mask(seg, value[i]);
+                if (state & found)
+                {
+                    return i + 1 - length;
+                }
+            }
+            return Str::npos;
+        }
+        for (size_t i = pos; i + length <= end; i++)
+        {
+            if (match_at(seg, value, i))
+            {
+                return i;
+            }
+        }
+        return Str::npos;
+    }
+
+    bool _ignore_case;
+    bool _has_star;
+    size_t _min_length;
+    std::vector<segment> _segments;
+    std::vector<char_class> _classes;
+};
+
+// Matches a value against many glob patterns in one pass. Patterns without
+// wildcards, and plain "lit*" / "*lit" patterns, are kept in hash tables keyed
+// by their literal text, so those cost one lookup per distinct literal length;
+// only the remaining patterns are tried one by one.
+template <typename Str>
+struct glob_set
+{
+    glob_set(bool ignore_case = false)
+        : _ignore_case(ignore_case), _suffixes(true)
+    {}
+
+    // returns the index of the pattern, as reported by match_all
+    size_t add(Str const& pattern)
+    {
+        size_t index = _patterns.size();
+        _patterns.push_back(glob_pattern<Str>(pattern, _ignore_case));
+        glob_pattern<Str> const& glob = _patterns.back();
+        Str literal;
+        if (!glob.has_wildcards())
+        {
+            glob.literal_prefix(literal);
+            _exact.add(literal, index);
+        }
+        else if (glob.literal_prefix(literal))
+        {
+            _prefixes.add(literal, index);
+        }
+        else if (glob.literal_suffix(literal))
+        {
+            _suffixes.add(literal, index);
+        }
+        else
+        {
+            _others.push_back(index);
+        }
+        return index;
+    }
+
+    size_t size() const
+    {
+        return _patterns.size();
+    }
+
+    bool match_any(Str const& value) const
+    {
+        return scan(value, nullptr);
+    }
+
+    // indices of all matching patterns, in increasing order
+    std::vector<size_t> match_all(Str const& value) const
+    {
+        std::vector<size_t> matches;
+        scan(value, &matches);
+        std::sort(matches.begin(), matches.end());
+        return matches;
+    }
+
+private:
+    typedef typename Str::value_type char_type;
+    typedef typename Str::traits_type traits_type;
+
+    // Literals grouped by the hash of their text, so a slice of the probed
+    // value can be looked up in place without building a key string. Suffix
+    // tables hash from the last character backwards, so that the hashes of
+    // all prefixes (or suffixes) of a value come from one incremental pass.
+    // A small bit filter rejects most misses before the map is touched.
+    struct literal_table
+    {
+        literal_table(bool reverse = false)
+            : _reverse(reverse), _filter(filter_bits / 64, 0)
+        {}
+
+        static const uint64_t hash_basis = 14695981039346656037ull;
+
+        // FNV-1a step over one character
+        static uint64_t hash_step(uint64_t h, char_type c)
+        {
+            return (h ^ static_cast<uint64_t>(c)) * 1099511628211ull;
+        }
+
+        uint64_t hash(const char_type* data, size_t length) const
+        {
+            uint64_t h = hash_basis;
+            for (size_t i = 0; i < length; i++)
+            {
+                h = hash_step(h, data[_reverse ? length - 1 - i : i]);
+            }
+            return h;
+        }
+
+        void add(Str const& literal, size_t index)
+        {
+            uint64_t h = hash(literal.data(), literal.size());
+            _filter[(h >> 32) % filter_bits / 64] |= uint64_t(1) << ((h >> 32) % 64);
+            std::vector<entry>& bucket = _buckets[static_cast<size_t>(h)];
+            for (auto& e : bucket)
+            {
+                if (e.text == literal)
+                {
+                    e.indices.push_back(index);
+                    return;
+                }
+            }
+            entry e;
+            e.text = literal;
+            e.indices.push_back(index);
+            bucket.push_back(e);
+            if (std::find(lengths.begin(), lengths.end(), literal.size()) == lengths.end())
+            {
+                lengths.insert(std::upper_bound(lengths.begin(), lengths.end(), literal.size()), literal.size());
+            }
+        }
+
+        // h must be hash(data, length)
+        std::vector<size_t> const* find(uint64_t h, const char_type* data, size_t length) const
+        {
+            if (!(_filter[(h >> 32) % filter_bits / 64] & (uint64_t(1) << ((h >> 32) % 64))))
+            {
+                return nullptr;
+            }
+            auto it = _buckets.find(static_cast<size_t>(h));
+            if (it == _buckets.end())
+            {
+                return nullptr;
+            }
+            for (auto const& e : it->second)
+            {
+                if (e.text.size() == length && traits_type::compare(e.text.data(), data, length) == 0)
+                {
+                    return &e.indices;
+                }
+            }
+            return nullptr;
+        }
+
+        std::vector<size_t> lengths;    // distinct literal lengths, ascending
+
+    private:
+        struct entry
+        {
+            Str text;
+            std::vector<size_t> indices;
+        };
+
+        static const size_t filter_bits = 4096;
+
+        bool _reverse;
+        std::vector<uint64_t> _filter;
+        std::unordered_map<size_t, std::vector<entry>> _buckets;
+    };
+
+    static bool collect(std::vector<size_t> const* indices, std::vector<size_t>* matches)
+    {
+        if (indices == nullptr)
+        {
+            return false;
+        }
+        if (matches)
+        {
+            matches->insert(matches->end(), indices->begin(), indices->end());
+        }
+        return true;
+    }
+
+    bool scan(Str const& value, std::vector<size_t>* matches) const
+    {
+        // the value is probed in place unless it has to be case folded
+        const char_type* key = value.data();
+        size_t size = value.size();
+        if (_ignore_case)
+        {
+            static thread_local Str folded;
+            folded.assign(value);
+            for (auto& c : folded)
+            {
+                c = fold_case(c);
+            }
+            key = folded.data();
+        }
+        bool found = collect(_exact.find(_exact.hash(key, size), key, size), matches);
+        if (found && !matches)
+        {
+            return true;
+        }
+        uint64_t h = literal_table::hash_basis;
+        size_t hashed = 0;
+        for (size_t length : _prefixes.lengths)
+        {
+            if (length > size)
+            {
+                break;
+            }
+            for (; hashed < length; hashed++)
+            {
+                h = literal_table::hash_step(h, key[hashed]);
+            }
+            if (collect(_prefixes.find(h, key, length), matches) && !matches)
+            {
+                return true;
+            }
+        }
+        h = literal_table::hash_basis;
+        hashed = 0;
+        for (size_t length : _suffixes.lengths)
+        {
+            if (length > size)
+            {
+                break;
+            }
+            for (; hashed < length; hashed++)
+            {
+                h = literal_table::hash_step(h, key[size - 1 - hashed]);
+            }
+            if (collect(_suffixes.find(h, key + size - length, length), matches) && !matches)
+            {
+                return true;
+            }
+        }
+        found = found || (matches && !matches->empty());
+        for (size_t index : _others)
+        {
+            if ((!found || matches) && _patterns[index].match(value))
+            {
+                if (!matches)
+                {
+                    return true;
+                }
+                matches->push_back(index);
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    bool _ignore_case;
+    std::vector<glob_pattern<Str>> _patterns;
+    literal_table _exact;
+    literal_table _prefixes;
+    literal_table _suffixes;
+    std::vector<size_t> _others;
+};
+
 template <typename Str>
 struct string_utility
 {
+    struct fuzzy_match
+    {
+        size_t index;
+        size_t distance;
+    };
 
     static Str to_upper(const Str& str)
     {
@@ -211,6 +1442,115 @@ struct string_utility
         }
         return ss;
     }
+
+    static size_t edit_distance(Str const& str1, Str const& str2, bool ignore_case = false,
+                                size_t max_distance = size_t(-1))
+    {
+        if (str1.size() > str2.size())
+        {
+            return edit_distance(str2, str1, ignore_case, max_distance);
+        }
+        if (str1.size() <= 64)
+        {
+            return levenshtein_pattern<Str>::distance_once(str1, str2, ignore_case, max_distance);
+        }
+        levenshtein_pattern<Str> pattern(str1, ignore_case);
+        return pattern.distance(str2, max_distance);
+    }
+
+    // Finds every dictionary entry within max_distance edits of query, ordered
+    // by distance and then by position. threads == 0 uses all hardware threads.
+    static std::vector<fuzzy_match> fuzzy_find(Str const& query, std::vector<Str> const& dictionary,
+                                               size_t max_distance, bool ignore_case = false,
+                                               unsigned threads = 1)
+    {
+        levenshtein_pattern<Str> pattern(query, ignore_case);
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        size_t chunks = std::min<size_t>(threads, std::max<size_t>(1, dictionary.size() / 1024));
+        std::vector<std::vector<fuzzy_match>> partial(chunks);
+        auto scan = [&](size_t chunk)
+        {
+            size_t first = dictionary.size() * chunk / chunks;
+            size_t last = dictionary.size() * (chunk + 1) / chunks;
+            for (size_t i = first; i < last; i++)
+            {
+                if (!pattern.may_match(dictionary[i], max_distance))
+                {
+                    continue;
+                }
+                size_t d = pattern.distance(dictionary[i], max_distance);
+                if (d <= max_distance)
+                {
+                    fuzzy_match match = { i, d };
+                    partial[chunk].push_back(match);
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (size_t chunk = 1; chunk < chunks; chunk++)
+        {
+            workers.push_back(std::thread(scan, chunk));
+        }
+        scan(0);
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        std::vector<fuzzy_match> matches;
+        for (auto const& part : partial)
+        {
+            matches.insert(matches.end(), part.begin(), part.end());
+        }
+        std::stable_sort(matches.begin(), matches.end(),
+            [](fuzzy_match const& a, fuzzy_match const& b) { return a.distance < b.distance; });
+        return matches;
+    }
+
+    // Sorts in std::char_traits order, or by the case folding of
+    // equals_ignore_case, keeping equal strings in input order. At most
+    // threads threads run at once; threads == 0 uses all hardware threads.
+    template <typename It>
+    static void sort_strings(It first, It last, bool ignore_case = false, unsigned threads = 1)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        string_sorter<Str> sorter(ignore_case);
+        sorter.sort(first, last, threads);
+    }
+
+    static void sort_strings(std::vector<Str>& strings, bool ignore_case = false, unsigned threads = 1)
+    {
+        sort_strings(strings.begin(), strings.end(), ignore_case, threads);
+    }
+
+    // Sorts and removes duplicates, keeping the first occurrence of each, and
+    // returns the new end of the range.
+    template <typename It>
+    static It unique_strings(It first, It last, bool ignore_case = false, unsigned threads = 1)
+    {
+        typedef typename std::iterator_traits<It>::value_type value_type;
+        sort_strings(first, last, ignore_case, threads);
+        string_sorter<Str> sorter(ignore_case);
+        return std::unique(first, last,
+            [&sorter](value_type const& a, value_type const& b) { return sorter.equal(a, b); });
+    }
+
+    static void unique_strings(std::vector<Str>& strings, bool ignore_case = false, unsigned threads = 1)
+    {
+        strings.erase(unique_strings(strings.begin(), strings.end(), ignore_case, threads), strings.end());
+    }
+
+    // Shell style wildcard match; compile a glob_pattern to match many values.
+    static bool glob_match(Str const& value, Str const& pattern, bool ignore_case = false)
+    {
+        return glob_pattern<Str>(pattern, ignore_case).match(value);
+    }
 };
 
 typedef string_utility<std::string> string_utility_a;
@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 
 int main()
@@ -17,5 +18,22 @@ int main()
     assert(string_convert::ansi_to_utf8(ansi_str) == utf8_str);
     assert(string_convert::utf8_to_ansi(utf8_str) == ansi_str);
 
+    std::string json_str = u8"say \"中文\"\n\tC:\\path\x01";
+    std::string json_esc = u8"say \\\"中文\\\"\\n\\tC:\\\\path\\u0001";
+    std::string output;
+    assert(string_convert::json_escape(json_str) == json_esc);
+    assert(string_convert::json_unescape(json_esc) == json_str);
+    assert(string_convert::json_escape(json_str, output, true) && output == json_esc);
+    assert(string_convert::json_escape("bad \xC3\x28", output, true) == false);
+    assert(string_convert::json_unescape("\\u4e2d\\/\\ud83d\\ude00") == u8"中/\U0001F600");
+    assert(string_convert::json_unescape("\\ud83d", output) == false);
+    assert(string_convert::json_unescape("ab\\x") == "ab\\x");
+    assert(string_convert::json_unescape("\\ud83d!\\n\\") == "\\ud83d!\n\\");
+    std::vector<char> buffer(string_convert::json_escape_bound(json_str.size()));
+    size_t length = string_convert::json_escape(json_str.data(), json_str.size(), &buffer[0]);
+    assert(std::string(&buffer[0], length) == json_esc);
+    length = string_convert::json_unescape(json_esc.data(), json_esc.size(), &buffer[0]);
+    assert(std::string(&buffer[0], length) == json_str);
+
     return 0;
 }
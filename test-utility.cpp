@@ -29,6 +29,57 @@ int main()
     assert(string_utility_a::to_hex_string(123, 4) == "007b");
     assert(string_utility_a::split(test, "1")[0] == " aBc中文");
     assert(string_utility_a::split(test, "1")[1] == "23 ");
+    assert(string_utility_a::edit_distance("kitten", "sitting") == 3);
+    assert(string_utility_a::edit_distance("Kitten", "kITTEN") == 6);
+    assert(string_utility_a::edit_distance("Kitten", "kITTEN", true) == 0);
+    assert(string_utility_a::edit_distance("kitten", "sitting", false, 1) == 2);
+    assert(string_utility_a::edit_distance(std::string(100, 'a') + "b", std::string(100, 'a') + "cd") == 2);
+    std::vector<std::string> dict = { "select", "delete", "Insert", "update", "selects" };
+    auto matches = string_utility_a::fuzzy_find("inser", dict, 1, true);
+    assert(matches.size() == 1 && matches[0].index == 2 && matches[0].distance == 1);
+    matches = string_utility_a::fuzzy_find("selectt", dict, 2);
+    assert(matches.size() == 2 && matches[0].index == 0 && matches[1].index == 4);
+    std::vector<std::string> words = string_utility_a::split("pear Apple apple fig apples pear fig", " ");
+    string_utility_a::sort_strings(words);
+    assert((words == std::vector<std::string>{ "Apple", "apple", "apples", "fig", "fig", "pear", "pear" }));
+    string_utility_a::unique_strings(words);
+    assert((words == std::vector<std::string>{ "Apple", "apple", "apples", "fig", "pear" }));
+    string_utility_a::unique_strings(words, true);
+    assert((words == std::vector<std::string>{ "Apple", "apples", "fig", "pear" }));
+    words = string_utility_a::split("fig apple FIG Apple pear APPLE", " ");
+    string_utility_a::unique_strings(words, true);
+    assert((words == std::vector<std::string>{ "apple", "fig", "pear" }));
+    std::vector<std::string> organ_pipe;
+    for (int i = 0; i < 300000; i++)
+    {
+        organ_pipe.push_back(string_utility_a::to_hex_string(i < 150000 ? i : 299999 - i, 8));
+    }
+    std::vector<std::string> sorted = organ_pipe;
+    std::sort(sorted.begin(), sorted.end());
+    string_utility_a::sort_strings(organ_pipe, false, 4);
+    assert(organ_pipe == sorted);
+    assert(string_utility_a::glob_match("server.log", "*.log") == true);
+    assert(string_utility_a::glob_match("server.LOG", "*.log") == false);
+    assert(string_utility_a::glob_match("server.LOG", "*.log", true) == true);
+    assert(string_utility_a::glob_match("user_42_name", "user_??_*") == true);
+    assert(string_utility_a::glob_match("user_4_name", "user_??_*") == false);
+    assert(string_utility_a::glob_match("beef", "[a-f]*") == true);
+    assert(string_utility_a::glob_match("Beef", "[!a-f]*") == true);
+    assert(string_utility_a::glob_match("a*b", "a\\*b") == true && string_utility_a::glob_match("axb", "a\\*b") == false);
+    assert(string_utility_a::glob_match("src/main/util.cpp", "src/*/*.cpp") == true);
+    assert(string_utility_a::glob_match("disk: ERROR 7", "*e?ror*", true) == true);
+    assert(string_utility_a::glob_match("disk: ERROR 7", "*e?ror*") == false);
+    glob_pattern<std::string> glob("*a*b*c*");
+    assert(glob.match("xxaxxbxxc") == true && glob.match("cba") == false);
+    glob_set<std::string> globs(true);
+    globs.add("*.log");
+    globs.add("README");
+    globs.add("tmp*");
+    globs.add("[a-c]?.txt");
+    assert((globs.match_all("Tmp.LOG") == std::vector<size_t>{ 0, 2 }));
+    assert((globs.match_all("readme") == std::vector<size_t>{ 1 }));
+    assert((globs.match_all("b1.txt") == std::vector<size_t>{ 3 }));
+    assert(globs.match_any("notes.txt") == false);
 
     std::wstring testw = L" aBc中文123 ";
     assert(string_utility_w::to_upper(testw) == L" ABC中文123 ");
@@ -51,6 +102,13 @@ int main()
     assert(string_utility_w::to_hex_string(123, 4) == L"007b");
     assert(string_utility_w::split(testw, L"1")[0] == L" aBc中文");
     assert(string_utility_w::split(testw, L"1")[1] == L"23 ");
+    assert(string_utility_w::edit_distance(L"中文123", L"中123") == 1);
+    assert(string_utility_w::edit_distance(L"aBc中文", L"ABC中文", true) == 0);
+    std::vector<std::wstring> wwords = string_utility_w::split(L"中文 b A a 中", L" ");
+    string_utility_w::unique_strings(wwords, true);
+    assert(wwords.size() == 4 && wwords[1] == L"b" && wwords[2] == L"中" && wwords[3] == L"中文");
+    assert(string_utility_w::glob_match(L"中文123", L"中?[0-9]*") == true);
+    assert(string_utility_w::glob_match(L"ABC中文", L"abc*", true) == true);
 
 
     return 0;